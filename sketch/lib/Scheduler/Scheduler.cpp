@@ -17,18 +17,20 @@ Scheduler::Scheduler(unsigned long loopInterval) {
  * any scheduled callback functions and then delete it from the
  * collection of scheduled callback functions (unless the callback was
  * scheduled with a repeat flag in which cast the callback will be
- * re-scheduled).
+ * re-scheduled). Any running tasks are then resumed and those which
+ * have completed are removed.
  */
 
 void Scheduler::loop() {
     static unsigned long deadline = 0UL;
     unsigned long now = millis();
 
-    if ((now > deadline) && (this->size > 0)) {
-        for (unsigned int i = 0; i < 10; i++) {
-            if (this->callbacks[i].when >= now) {
+    if ((long) (now - deadline) > 0) {
+        for (unsigned int i = 0; ((this->size > 0) && (i < 10)); i++) {
+            if ((this->callbacks[i].func) && ((long) (now - this->callbacks[i].when) >= 0)) {
                 this->callbacks[i].func();
                 if (!this->callbacks[i].repeat) {
+                    this->callbacks[i].func = NULL;
                     this->callbacks[i].when = 0UL;
                     this->size--;
                 } else {
@@ -36,6 +38,11 @@ void Scheduler::loop() {
                 }
             }
         }
+        for (unsigned int i = 0; i < SCHEDULER_TASKS; i++) {
+            if ((this->tasks[i]) && (!this->tasks[i]->resume())) {
+                this->tasks[i] = NULL;
+            }
+        }
         deadline = (now + this->loopInterval);
     } 
 }
@@ -43,7 +50,9 @@ void Scheduler::loop() {
 /**********************************************************************
  * Schedule <func> for callback in <interval> milliseconds. If <repeat>
  * is omitted or false, then the <func> will be called once, otherwise
- * it will be called repeatedly every <interval> milliseconds.
+ * it will be called repeatedly every <interval> milliseconds. Returns
+ * false if the callback table is full. Due times are compared by
+ * subtraction so that scheduling survives millis() rollover.
  */
 
 bool Scheduler::schedule(void (*func)(), unsigned long interval, bool repeat) {
@@ -51,7 +60,7 @@ bool Scheduler::schedule(void (*func)(), unsigned long interval, bool repeat) {
 
     if (this->size < 10) {
         for (unsigned int i = 0; i < 10; i++) {
-            if (this->callbacks[i].when == 0UL) {
+            if (this->callbacks[i].func == NULL) {
                 this->callbacks[i].func = func;
                 this->callbacks[i].interval = interval;
                 this->callbacks[i].repeat = repeat;
@@ -65,3 +74,52 @@ bool Scheduler::schedule(void (*func)(), unsigned long interval, bool repeat) {
     return(retval);
 }
 
+/**********************************************************************
+ * Start <task> from the top of its task function. The task will be
+ * resumed on each pass of loop() until it completes or is cancelled.
+ * Returns false if <task> is already running or if there is no room
+ * for another task.
+ */
+
+bool Scheduler::run(Task *task) {
+    bool retval = false;
+
+    for (unsigned int i = 0; i < SCHEDULER_TASKS; i++) {
+        if (this->tasks[i] == task) return(false);
+    }
+    for (unsigned int i = 0; i < SCHEDULER_TASKS; i++) {
+        if (this->tasks[i] == NULL) {
+            task->reset();
+            this->tasks[i] = task;
+            retval = true;
+            break;
+        }
+    }
+    return(retval);
+}
+
+/**********************************************************************
+ * Stop <task> wherever it is suspended. The task can subsequently be
+ * restarted from the top with run().
+ */
+
+void Scheduler::cancel(Task *task) {
+    for (unsigned int i = 0; i < SCHEDULER_TASKS; i++) {
+        if (this->tasks[i] == task) {
+            this->tasks[i] = NULL;
+            task->reset();
+        }
+    }
+}
+
+/**********************************************************************
+ * Returns true if <task> has been started with run() and has neither
+ * completed nor been cancelled.
+ */
+
+bool Scheduler::isRunning(Task *task) {
+    for (unsigned int i = 0; i < SCHEDULER_TASKS; i++) {
+        if (this->tasks[i] == task) return(true);
+    }
+    return(false);
+}
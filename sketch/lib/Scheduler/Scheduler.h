@@ -20,18 +20,28 @@
  *   Serial.println("Hello world");
  * }
  * 
+ * Multi-step sequences can be written as stackless tasks (see Task.h)
+ * and handed to the scheduler with run(). Each task is resumed on
+ * every pass of loop() until its task function completes.
+ * 
  */
 
 #ifndef SCHEDULER_H
 #define SCHEDULER_H
 
 #include <Arduino.h>
+#include "Task.h"
+
+#define SCHEDULER_TASKS 8
 
 class Scheduler {
 
 public:
     Scheduler(unsigned long loopInterval = 20UL);
     bool schedule(void (*func)(), unsigned long interval, bool repeat = false);
+    bool run(Task *task);
+    void cancel(Task *task);
+    bool isRunning(Task *task);
     void loop();
 
 protected:
@@ -40,6 +50,7 @@ private:
     struct Callback { void (*func)(); unsigned long interval; unsigned long when; bool repeat; };
     Callback callbacks[10] = { {NULL,0UL,0UL,false},{NULL,0UL,0UL,false},{NULL,0UL,0UL,false},{NULL,0UL,0UL,false},{NULL,0UL,0UL,false},{NULL,0UL,0UL,false},{NULL,0UL,0UL,false},{NULL,0UL,0UL,false},{NULL,0UL,0UL,false},{NULL,0UL,0UL,false} };
     int size = 0;
+    Task *tasks[SCHEDULER_TASKS] = { NULL,NULL,NULL,NULL,NULL,NULL,NULL,NULL };
     unsigned long loopInterval;
 
 };
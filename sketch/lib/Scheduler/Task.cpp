@@ -0,0 +1,43 @@
+#include "Task.h"
+
+/**********************************************************************
+ * Create a new Task which will execute <func>. The task does nothing
+ * until it is passed to Scheduler::run().
+ */
+
+Task::Task(bool (*func)(Task *)) {
+    this->func = func;
+    this->reset();
+}
+
+/**********************************************************************
+ * Re-enter the task function at its last suspension point. Returns
+ * true if the task has suspended itself again or false if it has run
+ * to completion.
+ */
+
+bool Task::resume() {
+    return((this->func)?this->func(this):false);
+}
+
+/**********************************************************************
+ * Return the task to its initial state so that the next resume()
+ * starts from the top of the task function.
+ */
+
+void Task::reset() {
+    this->lc = 0;
+    this->timer = 0UL;
+    this->snapshot = 0;
+}
+
+/**********************************************************************
+ * Returns true if the task is suspended part way through its task
+ * function. A task which has been queued with Scheduler::run() but not
+ * yet resumed is not suspended: use Scheduler::isRunning() to find out
+ * whether a task is queued.
+ */
+
+bool Task::isSuspended() {
+    return(this->lc != 0);
+}
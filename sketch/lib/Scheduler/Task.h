@@ -0,0 +1,115 @@
+/**********************************************************************
+ * Task - stackless cooperative task (protothread) for use with
+ * Scheduler.
+ * 2022 (c) Paul Reeve.
+ *
+ * A Task wraps a task function which is re-entered on every pass of
+ * Scheduler::loop() and which resumes from wherever it last suspended
+ * itself. Suspension points are introduced with the TASK_* macros,
+ * so a multi-step sequence can be written top-to-bottom without
+ * blocking the loop and without a chain of one-shot callbacks.
+ *
+ * Each suspended task holds only its resume point, a timer and a
+ * snapshot value. Local variables in a task function do NOT survive a
+ * suspension: keep anything that must persist in globals or statics.
+ * TASK_* macros must not be used inside a switch statement.
+ *
+ * Example:
+ *
+ * Scheduler myScheduler(LOOP_INTERVAL);
+ * Task deployTask(deploySequence);
+ *
+ * void loop() {
+ *   myScheduler.loop();
+ *   if (deployRequested && !myScheduler.isRunning(&deployTask)) {
+ *     myScheduler.run(&deployTask);
+ *   }
+ * }
+ *
+ * bool deploySequence(Task *task) {
+ *   TASK_BEGIN(task);
+ *   spudpole.setOperatingState(Windlass::DEPLOYING);
+ *   TASK_AWAIT(task, spudpole.isDeployed());
+ *   spudpole.setOperatingState(Windlass::STOPPED);
+ *   TASK_DELAY(task, 2000UL);
+ *   TASK_AWAIT_EDGE(task, debouncer.channelState(GPIO_RETRIEVE));
+ *   spudpole.setOperatingState(Windlass::RETRIEVING);
+ *   TASK_AWAIT_CHANGE(task, spudpole.getOperatingState());
+ *   saveOperatingTime(spudpole.getOperatingTime());
+ *   TASK_END(task);
+ * }
+ */
+
+#ifndef TASK_H
+#define TASK_H
+
+#include <Arduino.h>
+
+/**********************************************************************
+ * Open the body of a task function. Must be the first statement.
+ */
+#define TASK_BEGIN(task) switch ((task)->lc) { case 0:
+
+/**********************************************************************
+ * Suspend the task until <cond> is true. <cond> is re-evaluated each
+ * time the task is resumed.
+ */
+#define TASK_AWAIT(task, cond) do { \
+  (task)->lc = __LINE__; __attribute__((fallthrough)); case __LINE__: \
+  if (!(cond)) return(true); \
+} while (0)
+
+/**********************************************************************
+ * Suspend the task for <interval> milliseconds.
+ */
+#define TASK_DELAY(task, interval) do { \
+  (task)->timer = millis(); \
+  TASK_AWAIT(task, ((millis() - (task)->timer) >= (unsigned long) (interval))); \
+} while (0)
+
+/**********************************************************************
+ * Suspend the task until the integer value of <expr> differs from its
+ * value on entry. Use with Windlass::getOperatingState() and the like.
+ */
+#define TASK_AWAIT_CHANGE(task, expr) do { \
+  (task)->snapshot = (int) (expr); \
+  TASK_AWAIT(task, ((int) (expr) != (task)->snapshot)); \
+} while (0)
+
+/**********************************************************************
+ * Suspend the task until a debounced input changes state. <expr> is
+ * normally a call to Debouncer::channelState().
+ */
+#define TASK_AWAIT_EDGE(task, expr) TASK_AWAIT_CHANGE(task, ((expr)?1:0))
+
+/**********************************************************************
+ * Yield once, resuming on the next pass of the scheduler.
+ */
+#define TASK_YIELD(task) do { \
+  (task)->lc = __LINE__; return(true); case __LINE__:; \
+} while (0)
+
+/**********************************************************************
+ * Close the body of a task function. Must be the last statement. The
+ * task is reset so that it can be run again.
+ */
+#define TASK_END(task) } (task)->lc = 0; return(false)
+
+class Task {
+
+public:
+    Task(bool (*func)(Task *));
+    bool resume();
+    void reset();
+    bool isSuspended();
+
+    unsigned short lc;
+    unsigned long timer;
+    int snapshot;
+
+private:
+    bool (*func)(Task *);
+
+};
+
+#endif
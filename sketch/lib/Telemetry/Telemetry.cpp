@@ -0,0 +1,112 @@
+/**********************************************************************
+ * Telemetry.cpp - compact binary telemetry for windlass state.
+ * 2022 (c) Paul Reeve <preeve@pdjr.eu>
+ */
+
+#include <Telemetry.h>
+
+Telemetry::Telemetry(Print *stream, ElectricWindlass *windlass, Debouncer *debouncer, unsigned int keyframeInterval) {
+  this->init(stream, windlass, NULL, debouncer, keyframeInterval);
+}
+
+Telemetry::Telemetry(Print *stream, Spudpole *spudpole, Debouncer *debouncer, unsigned int keyframeInterval) {
+  this->init(stream, spudpole, spudpole, debouncer, keyframeInterval);
+}
+
+/**********************************************************************
+ * Encode and write one frame. Every <keyframeInterval>th call emits a
+ * keyframe. Returns the number of bytes written, which is zero if
+ * nothing has changed since the last frame and no keyframe is due.
+ */
+size_t Telemetry::send() {
+  Snapshot current;
+  bool keyframe = (this->framesToKeyframe == 0);
+  size_t size = 0;
+
+  this->sample(&current);
+  this->document.clear();
+  if (keyframe || (current.operatingState != this->last.operatingState)) this->document["s"] = current.operatingState;
+  if (keyframe || (current.rotationCount != this->last.rotationCount)) this->document["r"] = current.rotationCount;
+  if (keyframe || (current.operatingTime != this->last.operatingTime)) this->document["t"] = current.operatingTime;
+  if (keyframe || (current.controllerVoltage != this->last.controllerVoltage)) this->document["v"] = current.controllerVoltage;
+  if (keyframe || (current.motorCurrent != this->last.motorCurrent)) this->document["i"] = current.motorCurrent;
+  if (this->spudpole) {
+    if (keyframe || (current.dockedStatus != this->last.dockedStatus)) this->document["d"] = current.dockedStatus;
+    if (keyframe || (current.deployedStatus != this->last.deployedStatus)) this->document["p"] = current.deployedStatus;
+  }
+  if (this->debouncer) {
+    if (keyframe || (current.switches != this->last.switches)) this->document["w"] = current.switches;
+  }
+
+  if (this->document.size() > 0) {
+    if (keyframe) this->document["k"] = 1;
+    this->document["n"] = (uint8_t) this->frameCount;
+    size = this->encodeFrame(serializeMsgPack(this->document, this->buffer, TELEMETRY_BUFFER_SIZE));
+    if (size > 0) this->stream->write(this->frame, size);
+    this->frameCount++;
+    this->last = current;
+  }
+  this->framesToKeyframe = (keyframe)?this->keyframeInterval:(this->framesToKeyframe - 1);
+  return(size);
+}
+
+/**********************************************************************
+ * Force the next call to send() to emit a keyframe. Useful when the
+ * receiver is known to have (re)connected.
+ */
+void Telemetry::requestKeyframe() {
+  this->framesToKeyframe = 0;
+}
+
+unsigned long Telemetry::getFrameCount() {
+  return(this->frameCount);
+}
+
+//*****************************************************************************
+// Private methods
+//*****************************************************************************
+
+void Telemetry::init(Print *stream, ElectricWindlass *windlass, Spudpole *spudpole, Debouncer *debouncer, unsigned int keyframeInterval) {
+  this->stream = stream;
+  this->windlass = windlass;
+  this->spudpole = spudpole;
+  this->debouncer = debouncer;
+  this->keyframeInterval = (keyframeInterval > 0)?(keyframeInterval - 1):0;
+  this->framesToKeyframe = 0;
+  this->frameCount = 0UL;
+}
+
+void Telemetry::sample(Telemetry::Snapshot *snapshot) {
+  snapshot->operatingState = this->windlass->getOperatingState();
+  snapshot->rotationCount = this->windlass->getRotationCount();
+  snapshot->operatingTime = this->windlass->getOperatingTime();
+  snapshot->controllerVoltage = lround(this->windlass->getControllerVoltage() / TELEMETRY_VOLTAGE_RESOLUTION);
+  snapshot->motorCurrent = lround(this->windlass->getMotorCurrent() / TELEMETRY_CURRENT_RESOLUTION);
+  snapshot->dockedStatus = (this->spudpole)?this->spudpole->getDockedStatus():0;
+  snapshot->deployedStatus = (this->spudpole)?this->spudpole->getDeployedStatus():0;
+  snapshot->switches = (this->debouncer)?this->debouncer->getStates():0;
+}
+
+/**********************************************************************
+ * COBS encode the <size> byte message in buffer into frame and append
+ * the 0x00 frame delimiter. TELEMETRY_BUFFER_SIZE is less than 254, so
+ * encoding adds exactly one byte. Returns the frame length or zero if
+ * there was no message.
+ */
+size_t Telemetry::encodeFrame(size_t size) {
+  size_t code = 0;
+  size_t out = 1;
+
+  if (size == 0) return(0);
+  for (size_t i = 0; i < size; i++) {
+    if (this->buffer[i] == 0) {
+      this->frame[code] = (out - code);
+      code = out++;
+    } else {
+      this->frame[out++] = this->buffer[i];
+    }
+  }
+  this->frame[code] = (out - code);
+  this->frame[out++] = 0;
+  return(out);
+}
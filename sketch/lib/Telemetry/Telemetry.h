@@ -0,0 +1,102 @@
+/**********************************************************************
+ * Telemetry.h - compact binary telemetry for windlass state.
+ * 2022 (c) Paul Reeve <preeve@pdjr.eu>
+ *
+ * Telemetry encodes the state of an ElectricWindlass (or Spudpole) and,
+ * optionally, a Debouncer as a MessagePack map and writes it to a
+ * stream. A frame contains only the fields which have changed since
+ * the previous frame, except for a periodic keyframe which contains
+ * every field. The document and output buffers are fixed size members:
+ * nothing is allocated on the heap.
+ *
+ * Each frame is COBS encoded and terminated by a 0x00 byte, which
+ * never occurs inside an encoded frame. A receiver which connects
+ * mid-stream or loses a byte discards input up to the next 0x00 and
+ * then waits for a keyframe to resynchronise.
+ *
+ * Controller voltage and motor current are quantised to integer counts
+ * of TELEMETRY_VOLTAGE_RESOLUTION and TELEMETRY_CURRENT_RESOLUTION, so
+ * ADC noise below the resolution does not trigger a delta, and are sent
+ * as those counts (12.3V is "v":123 at the default resolution). Both
+ * resolutions can be overridden with build flags.
+ *
+ * Map keys:
+ *   "n" frame sequence number, wrapping at 256 (always present)
+ *   "k" 1 if the frame is a keyframe (keyframes only)
+ *   "s" Windlass::OperatingStates
+ *   "r" rotation count (deployed line length is derived from this)
+ *   "t" operating time (s)
+ *   "v" controller voltage (integer, units of TELEMETRY_VOLTAGE_RESOLUTION V)
+ *   "i" motor current (integer, units of TELEMETRY_CURRENT_RESOLUTION A)
+ *   "d" Spudpole docked status (Spudpole only)
+ *   "p" Spudpole deployed status (Spudpole only)
+ *   "w" debounced switch states (Debouncer only)
+ *
+ * Telemetry telemetry(&Serial, &spudpole, &debouncer);
+ *
+ * void setup() {
+ *   scheduler.schedule(sendTelemetry, 100UL, true);
+ * }
+ *
+ * void sendTelemetry() {
+ *   telemetry.send();
+ * }
+ */
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <Debouncer.h>
+#include <ElectricWindlass.h>
+#include <Spudpole.h>
+
+#define TELEMETRY_FIELDS 10
+#define TELEMETRY_BUFFER_SIZE 96
+#define TELEMETRY_FRAME_SIZE (TELEMETRY_BUFFER_SIZE + 2)
+#define TELEMETRY_KEYFRAME_INTERVAL 50
+
+#ifndef TELEMETRY_VOLTAGE_RESOLUTION
+#define TELEMETRY_VOLTAGE_RESOLUTION 0.1
+#endif
+
+#ifndef TELEMETRY_CURRENT_RESOLUTION
+#define TELEMETRY_CURRENT_RESOLUTION 0.1
+#endif
+
+class Telemetry {
+  public:
+    Telemetry(Print *stream, ElectricWindlass *windlass, Debouncer *debouncer = NULL, unsigned int keyframeInterval = TELEMETRY_KEYFRAME_INTERVAL);
+    Telemetry(Print *stream, Spudpole *spudpole, Debouncer *debouncer = NULL, unsigned int keyframeInterval = TELEMETRY_KEYFRAME_INTERVAL);
+    size_t send();
+    void requestKeyframe();
+    unsigned long getFrameCount();
+  private:
+    struct Snapshot {
+      unsigned char operatingState;
+      int rotationCount;
+      unsigned long operatingTime;
+      long controllerVoltage;
+      long motorCurrent;
+      unsigned char dockedStatus;
+      unsigned char deployedStatus;
+      unsigned char switches;
+    };
+    Print *stream;
+    ElectricWindlass *windlass;
+    Spudpole *spudpole;
+    Debouncer *debouncer;
+    unsigned int keyframeInterval;
+    unsigned int framesToKeyframe;
+    unsigned long frameCount;
+    Snapshot last;
+    StaticJsonDocument<JSON_OBJECT_SIZE(TELEMETRY_FIELDS)> document;
+    uint8_t buffer[TELEMETRY_BUFFER_SIZE];
+    uint8_t frame[TELEMETRY_FRAME_SIZE];
+    void init(Print *stream, ElectricWindlass *windlass, Spudpole *spudpole, Debouncer *debouncer, unsigned int keyframeInterval);
+    void sample(Snapshot *snapshot);
+    size_t encodeFrame(size_t size);
+};
+
+#endif
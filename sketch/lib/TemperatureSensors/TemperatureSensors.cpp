@@ -0,0 +1,147 @@
+/**********************************************************************
+ * TemperatureSensors.cpp - non-blocking DS18B20 temperature acquisition.
+ * 2022 (c) Paul Reeve <preeve@pdjr.eu>
+ */
+
+#include <Arduino.h>
+#include <TemperatureSensors.h>
+
+TemperatureSensors *TemperatureSensors::instance = NULL;
+
+TemperatureSensors::TemperatureSensors(OneWire *oneWire, unsigned long interval, unsigned char resolution) : sensors(oneWire) {
+  this->scheduler = NULL;
+  this->sensorCount = 0;
+  this->collectIndex = 0;
+  this->interval = interval;
+  this->conversionTime = 0UL;
+  this->lastUpdate = 0UL;
+  this->collecting = false;
+  this->resolution = resolution;
+  for (unsigned int i = 0; i < TEMPERATURESENSORS_SIZE; i++) this->temperatures[i] = DEVICE_DISCONNECTED_C;
+}
+
+/**********************************************************************
+ * Enumerate the sensors on the bus, cache their ROM addresses and
+ * start a repeating acquisition cycle on <scheduler>, issuing the first
+ * conversion immediately. The acquisition interval is stretched if
+ * necessary so that it is never shorter than the conversion time at
+ * the configured resolution. Returns false if this or another instance
+ * has already been started or if the acquisition cycle could not be
+ * scheduled.
+ */
+bool TemperatureSensors::begin(Scheduler *scheduler) {
+  bool retval = true;
+
+  if ((TemperatureSensors::instance) || (this->scheduler)) return(false);
+  this->scheduler = scheduler;
+  this->sensors.begin();
+  this->sensors.setWaitForConversion(false);
+  this->sensorCount = 0;
+  for (unsigned int i = 0; ((i < this->sensors.getDeviceCount()) && (this->sensorCount < TEMPERATURESENSORS_SIZE)); i++) {
+    if (this->sensors.getAddress(this->addresses[this->sensorCount], i)) {
+      this->sensors.setResolution(this->addresses[this->sensorCount], this->resolution);
+      this->sensorCount++;
+    }
+  }
+  this->conversionTime = this->sensors.millisToWaitForConversion(this->resolution);
+  if (this->interval <= this->conversionTime) this->interval = (this->conversionTime + 1UL);
+  TemperatureSensors::instance = this;
+  if (this->sensorCount > 0) {
+    retval = this->scheduler->schedule(TemperatureSensors::requestCallback, this->interval, true);
+    if (retval) this->request();
+  }
+  return(retval);
+}
+
+unsigned int TemperatureSensors::getSensorCount() {
+  return(this->sensorCount);
+}
+
+/**********************************************************************
+ * Returns the cached ROM address of sensor <index> or NULL if there is
+ * no such sensor.
+ */
+const unsigned char *TemperatureSensors::getAddress(unsigned int index) {
+  return((index < this->sensorCount)?this->addresses[index]:NULL);
+}
+
+/**********************************************************************
+ * Returns true if the most recent reading from sensor <index> was
+ * good.
+ */
+bool TemperatureSensors::isValid(unsigned int index) {
+  return((index < this->sensorCount) && (this->temperatures[index] != DEVICE_DISCONNECTED_C));
+}
+
+/**********************************************************************
+ * Returns the most recent reading from sensor <index> in degrees
+ * Celsius, or DEVICE_DISCONNECTED_C if no good reading is available.
+ * Never touches the bus.
+ */
+double TemperatureSensors::getTemperature(unsigned int index) {
+  return((index < this->sensorCount)?this->temperatures[index]:DEVICE_DISCONNECTED_C);
+}
+
+/**********************************************************************
+ * Returns the value of millis() when the last acquisition cycle
+ * completed.
+ */
+unsigned long TemperatureSensors::getLastUpdate() {
+  return(this->lastUpdate);
+}
+
+void TemperatureSensors::dumpConfiguration() {
+  for (unsigned int i = 0; i < this->sensorCount; i++) {
+    Serial.print("Temperature sensor "); Serial.print(i); Serial.print(": ");
+    for (unsigned int b = 0; b < 8; b++) {
+      if (this->addresses[i][b] < 16) Serial.print("0");
+      Serial.print(this->addresses[i][b], HEX);
+    }
+    Serial.print(" "); Serial.println(this->temperatures[i]);
+  }
+}
+
+//*****************************************************************************
+// Private methods
+//*****************************************************************************
+
+void TemperatureSensors::requestCallback() {
+  if (TemperatureSensors::instance) TemperatureSensors::instance->request();
+}
+
+void TemperatureSensors::collectCallback() {
+  if (TemperatureSensors::instance) TemperatureSensors::instance->collect();
+}
+
+/**********************************************************************
+ * Start a conversion on every sensor and return immediately, arranging
+ * for collect() to be called once the conversion time has expired.
+ * Does nothing if readings from the previous conversion are still
+ * being collected.
+ */
+void TemperatureSensors::request() {
+  if (!this->collecting) {
+    this->sensors.requestTemperatures();
+    this->collectIndex = 0;
+    this->collecting = this->scheduler->schedule(TemperatureSensors::collectCallback, this->conversionTime);
+  }
+}
+
+/**********************************************************************
+ * Read the scratchpad of one sensor and, if there are more sensors to
+ * read, reschedule for the next pass of the scheduler so that bus time
+ * is spread across loop iterations. If rescheduling fails the cycle is
+ * abandoned so that the next request() can start afresh.
+ */
+void TemperatureSensors::collect() {
+  if (this->collectIndex < this->sensorCount) {
+    this->temperatures[this->collectIndex] = this->sensors.getTempC(this->addresses[this->collectIndex]);
+    this->collectIndex++;
+  }
+  if (this->collectIndex < this->sensorCount) {
+    this->collecting = this->scheduler->schedule(TemperatureSensors::collectCallback, 1UL);
+  } else {
+    this->collecting = false;
+    this->lastUpdate = millis();
+  }
+}
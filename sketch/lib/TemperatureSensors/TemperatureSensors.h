@@ -0,0 +1,77 @@
+/**********************************************************************
+ * TemperatureSensors.h - non-blocking DS18B20 temperature acquisition.
+ * 2022 (c) Paul Reeve <preeve@pdjr.eu>
+ *
+ * DallasTemperature::requestTemperatures() normally blocks for the
+ * whole conversion time (750ms at 12-bit resolution). This class
+ * starts conversions on all sensors at once without waiting and
+ * uses Scheduler callbacks to collect the results when the conversion
+ * time has expired, reading one sensor per callback so that no single
+ * pass of the loop is held up. Sensor ROM addresses are discovered and
+ * cached by begin().
+ *
+ * Scheduler callbacks carry no context, so only one TemperatureSensors
+ * instance can be started per program, and only once: begin() fails
+ * for any other instance and on any repeated call.
+ *
+ * A new conversion is not started until every reading from the
+ * previous one has been collected. If a callback cannot be scheduled
+ * the cycle is abandoned and restarted at the next interval; the
+ * cached readings are then older than usual, which can be detected
+ * with getLastUpdate().
+ *
+ * OneWire oneWire(GPIO_ONEWIRE);
+ * TemperatureSensors temperatureSensors(&oneWire, 5000UL);
+ * Scheduler scheduler;
+ *
+ * void setup() {
+ *   temperatureSensors.begin(&scheduler);
+ * }
+ *
+ * void loop() {
+ *   scheduler.loop();
+ *   double t = temperatureSensors.getTemperature(0);
+ * }
+ */
+
+#ifndef TEMPERATURESENSORS_H
+#define TEMPERATURESENSORS_H
+
+#include <OneWire.h>
+#include <DallasTemperature.h>
+#include <Scheduler.h>
+
+#define TEMPERATURESENSORS_SIZE 8
+#define TEMPERATURESENSORS_RESOLUTION 12
+#define TEMPERATURESENSORS_INTERVAL 5000UL
+
+class TemperatureSensors {
+  public:
+    TemperatureSensors(OneWire *oneWire, unsigned long interval = TEMPERATURESENSORS_INTERVAL, unsigned char resolution = TEMPERATURESENSORS_RESOLUTION);
+    bool begin(Scheduler *scheduler);
+    unsigned int getSensorCount();
+    const unsigned char *getAddress(unsigned int index);
+    bool isValid(unsigned int index);
+    double getTemperature(unsigned int index);
+    unsigned long getLastUpdate();
+    void dumpConfiguration();
+  private:
+    static TemperatureSensors *instance;
+    static void requestCallback();
+    static void collectCallback();
+    DallasTemperature sensors;
+    Scheduler *scheduler;
+    DeviceAddress addresses[TEMPERATURESENSORS_SIZE];
+    double temperatures[TEMPERATURESENSORS_SIZE];
+    unsigned int sensorCount;
+    unsigned int collectIndex;
+    unsigned long interval;
+    unsigned long conversionTime;
+    unsigned long lastUpdate;
+    bool collecting;
+    unsigned char resolution;
+    void request();
+    void collect();
+};
+
+#endif